@@ -1,9 +1,17 @@
 #include "plugin.hpp"
 
 
+// Used until the engine reports its rate through onSampleRateChange.
+static const float DEFAULT_SAMPLE_RATE = 44100.f;
+
+
 struct BaselineTracker {
 	float current = 1.f; float target = 1.f; float startValue = 1.f;
-	float progress = 0.f;
+
+	// Recovery is timed in whole samples so segment lengths are exact regardless of the engine sample rate.
+	float sampleRate = DEFAULT_SAMPLE_RATE;
+	int progress = 0;
+	int length = 1;
 
 	float linExpRatio = 0.f;
 
@@ -15,14 +23,18 @@ struct BaselineTracker {
 	enum RunningMode { NORMAL, INVERTED } mode = NORMAL;
 	enum WeakeningMode { ALWAYS, UNTIL_RECOVERED } weakeningMode = ALWAYS;
 
-	float process(const float delta) {
+	BaselineTracker() {
+		length = toSamples(recoverySpeed);
+	}
+
+	float process() {
 		if (current == target) {
 			state = IDLE;
 			return current;
 		}
 
-		progress += delta;
-		float p = clamp(progress / recoverySpeed, 0.f, 1.f);
+		progress = std::min(progress + 1, length);
+		float p = static_cast<float>(progress) / static_cast<float>(length);
 
 		const float linP = p;
 		const float expP = easeInAndOut(p);
@@ -30,9 +42,9 @@ struct BaselineTracker {
 
 		current = crossfade(startValue, target, p);
 
-		if (p >= 1.f) {
+		if (progress >= length) {
 			current = target;
-			progress = 0.f;
+			progress = 0;
 			startValue = current;
 		}
 
@@ -53,16 +65,41 @@ struct BaselineTracker {
 		current = mode == NORMAL ? current - strength : current + strength;
 		current = clamp(current, 0.f, 1.f);
 		startValue = current;
-		progress = 0.f;
+		progress = 0;
+
+		return mode == NORMAL ? current == 0.f : current == 1.f;
+	}
+
+	// Continuous weakening: hold the baseline at least `depth` away from its target, then recover as usual.
+	// Unlike weaken(), this ignores the weakening mode: waiting out each recovery would turn a held duck into pumping.
+	void duck(const float depth) {
+		const float floor = mode == NORMAL ? 1.f - depth : depth;
+		if (mode == NORMAL ? current <= floor : current >= floor) {
+			return;
+		}
+
+		current = clamp(floor, 0.f, 1.f);
+		startValue = current;
+		progress = 0;
+	}
 
+	bool isFallen() const {
 		return mode == NORMAL ? current == 0.f : current == 1.f;
 	}
 
+	// Drop any in-flight weakening or recovery, keeping the running mode and timing settings.
+	void reset() {
+		current = target;
+		startValue = target;
+		progress = 0;
+		state = IDLE;
+	}
+
 	RunningMode invert() {
 		mode = mode == NORMAL ? INVERTED : NORMAL;
 		target = mode == NORMAL ? 1.f : 0.f;
 		startValue = current;
-		progress = 0.f;
+		progress = 0;
 		return mode;
 	}
 
@@ -71,7 +108,29 @@ struct BaselineTracker {
 	}
 
 	void setRecoverySpeed(float speed) {
-		recoverySpeed = std::max(speed, MIN_RECOVERY_SPEED);
+		speed = std::max(speed, MIN_RECOVERY_SPEED);
+		if (speed == recoverySpeed) {
+			return;
+		}
+
+		recoverySpeed = speed;
+		length = toSamples(recoverySpeed);
+	}
+
+	void setSampleRate(const float rate) {
+		if (rate == sampleRate) {
+			return;
+		}
+
+		// Keep an in-flight recovery at the same point in time.
+		progress = static_cast<int>(std::round(progress * rate / sampleRate));
+		sampleRate = rate;
+		length = toSamples(recoverySpeed);
+		progress = std::min(progress, length);
+	}
+
+	int toSamples(const float seconds) const {
+		return std::max(static_cast<int>(std::round(seconds * sampleRate)), 1);
 	}
 
 	static float easeInAndOut(const float p) {
@@ -97,6 +156,104 @@ struct BaselineTracker {
 };
 
 
+struct SamplePulse {
+	static constexpr float PULSE_DURATION = 1e-3f;
+
+	int remaining = 0;
+	int length = toSamples(DEFAULT_SAMPLE_RATE);
+
+	void setSampleRate(const float rate) {
+		const int newLength = toSamples(rate);
+		remaining = remaining * newLength / length;
+		length = newLength;
+	}
+
+	static int toSamples(const float rate) {
+		return std::max(static_cast<int>(std::round(PULSE_DURATION * rate)), 1);
+	}
+
+	void trigger() {
+		remaining = std::max(remaining, length);
+	}
+
+	void reset() {
+		remaining = 0;
+	}
+
+	bool process() {
+		if (remaining <= 0) {
+			return false;
+		}
+
+		remaining--;
+		return true;
+	}
+};
+
+
+// Peak / RMS level of a sidechain signal, evaluated once per block of samples.
+struct EnvelopeFollower {
+	static const int BLOCK_SIZE = 32;
+	// Peaks are held, and mean squares averaged, over this long so the envelope doesn't sag between half-cycles of slow signals.
+	static constexpr float WINDOW = 0.02f;
+
+	enum Mode { PEAK, RMS };
+
+	float accumulator = 0.f;
+	// Smoothed block peak, or smoothed mean square in RMS mode.
+	float envelope = 0.f;
+	float heldPeak = 0.f;
+	int holdBlocks = 0;
+	float meanSquare = 0.f;
+
+	void accumulate(const float in, const Mode mode) {
+		const float x = std::fabs(in);
+		accumulator = mode == PEAK ? std::max(accumulator, x) : accumulator + x * x;
+	}
+
+	void reset() {
+		accumulator = 0.f;
+		envelope = 0.f;
+		heldPeak = 0.f;
+		holdBlocks = 0;
+		meanSquare = 0.f;
+	}
+
+	// Rising levels are smoothed by the attack coefficient and falling ones decay with the release coefficient,
+	// so the envelope builds up across cycles of signals slower than a block.
+	float processBlock(const Mode mode, const float attackCoef, const float releaseCoef, const int windowBlocks, const float windowCoef) {
+		float blockValue;
+		if (mode == PEAK) {
+			if (accumulator >= heldPeak || holdBlocks <= 0) {
+				heldPeak = accumulator;
+				holdBlocks = windowBlocks;
+			}
+			holdBlocks--;
+			blockValue = heldPeak;
+		} else {
+			meanSquare += (accumulator / BLOCK_SIZE - meanSquare) * windowCoef;
+			blockValue = meanSquare;
+		}
+		accumulator = 0.f;
+
+		envelope += (blockValue - envelope) * (blockValue > envelope ? attackCoef : releaseCoef);
+		return mode == PEAK ? envelope : std::sqrt(envelope);
+	}
+};
+
+
+// Trigger events and sidechain duck amounts broadcast from a group leader to linked Phoenix instances on its right.
+struct PhoenixBusMessage {
+	int channels = 0;
+	int hitMask = 0;
+	int invertMask = 0;
+
+	// Per-lane duck amount in [0, 1]; each module scales it by its own hit strength.
+	bool sidechain = false;
+	float duckAmounts[16] = {};
+};
+
+
 struct Phoenix final : Module {
 	enum ParamId {
 		RISE_PARAM,
@@ -107,6 +264,10 @@ struct Phoenix final : Module {
 		AM_PARAM,
 		WM_PARAM,
 		LIN_EXP_PARAM,
+		SC_ATTACK_PARAM,
+		SC_THRESHOLD_PARAM,
+		SC_RANGE_PARAM,
+		SC_RELEASE_PARAM,
 		PARAMS_LEN
 	};
 	enum InputId {
@@ -132,12 +293,34 @@ struct Phoenix final : Module {
 	};
 
 	// TODO: Save / Load these
-	BaselineTracker baseline;
-
-	dsp::SchmittTrigger weakenTrigger;
-	dsp::SchmittTrigger invertTrigger;
-	dsp::PulseGenerator risen;
-	dsp::PulseGenerator fallen;
+	BaselineTracker baselines[16];
+
+	dsp::SchmittTrigger weakenTriggers[16];
+	dsp::SchmittTrigger invertTriggers[16];
+	SamplePulse risen[16];
+	SamplePulse fallen[16];
+
+	// One bit per voice, used to fire RISEN only on the edge into RECOVERED.
+	int recoveredMask = 0;
+
+	// Voices that drop out are reset so they don't resume stale when the channel count grows again.
+	int lastChannels = 1;
+
+	// When linked, hits and inverts come from the Phoenix on the left instead of our own inputs.
+	bool linked = false;
+	PhoenixBusMessage busMessages[2];
+
+	// In sidechain mode HIT is treated as audio and its level ducks the baseline continuously.
+	// Only a group leader runs the followers; linked modules receive the duck amounts over the bus.
+	bool sidechain = false;
+	EnvelopeFollower::Mode followerMode = EnvelopeFollower::PEAK;
+	EnvelopeFollower followers[16];
+	float duckAmounts[16] = {};
+	float duckTargets[16] = {};
+	float duckSteps[16] = {};
+	// One bit per voice that bottomed out while ducking; latched until the voice recovers so FALLEN fires once per episode.
+	int duckedMask = 0;
+	dsp::ClockDivider sidechainDivider;
 
 	dsp::BooleanTrigger omTrigger;
 	dsp::BooleanTrigger amTrigger;
@@ -163,8 +346,12 @@ struct Phoenix final : Module {
 		configParam(FALL_CV_PARAM, -1.f, 1.f, 0.f, "Fall CV");
 		configButton(OM_PARAM, "Output mode (BI 10V = green, UNI 10V = blue, BI 5V = orange, UNI 5V = cyan)");
 		configButton(AM_PARAM, "Attenuation mode (ATT = green, NUDGE = blue)");
-		configButton(WM_PARAM, "Weakening mode (ALWAYS = cyan, WAIT UNTIL RECOVERED = orange)");
+		configButton(WM_PARAM, "Weakening mode for hits (ALWAYS = cyan, WAIT UNTIL RECOVERED = orange); sidechain ducking always applies");
 		configParam(LIN_EXP_PARAM, 0.f, 1.f, 0.f, "Linear / Exponential rise");
+		configParam(SC_ATTACK_PARAM, 0.001f, 0.5f, 0.01f, "Sidechain attack", " ms", 0.f, 1000.f);
+		configParam(SC_THRESHOLD_PARAM, 0.f, 10.f, 1.f, "Sidechain threshold", " V")->description = "Sidechain level at which ducking starts";
+		configParam(SC_RANGE_PARAM, 0.1f, 10.f, 5.f, "Sidechain range", " V")->description = "Level above the threshold that ducks by the full hit strength";
+		configParam(SC_RELEASE_PARAM, 0.01f, 2.f, 0.1f, "Sidechain release", " ms", 0.f, 1000.f)->description = "How fast the detected level falls once the sidechain drops";
 		configInput(RISE_INPUT, "Rise CV (-5V/5V)");
 		configInput(FALL_INPUT, "Fall CV (-5V/5V)");
 		configInput(INVERT_INPUT, "Invert trigger");
@@ -174,10 +361,15 @@ struct Phoenix final : Module {
 		configOutput(FALLEN_OUTPUT, "Fallen");
 		configOutput(AUX_OUTPUT, "AUX (-5V/5V)");
 		configOutput(MAIN_OUTPUT, "Main");
+
+		getLeftExpander().producerMessage = &busMessages[0];
+		getLeftExpander().consumerMessage = &busMessages[1];
+
+		sidechainDivider.setDivision(EnvelopeFollower::BLOCK_SIZE);
 	}
 
 	void process(const ProcessArgs& args) override {
-		baseline.setLinExpRatio(getParam(LIN_EXP_PARAM).getValue());
+		const float linExpRatio = getParam(LIN_EXP_PARAM).getValue();
 
 		// Handle attenuation mode.
 		if (amTrigger.process(getParam(AM_PARAM).getValue())) {
@@ -185,59 +377,163 @@ struct Phoenix final : Module {
 		}
 
 		if (wmTrigger.process(getParam(WM_PARAM).getValue())) {
-			baseline.toggleWeaknessMode();
+			for (BaselineTracker& baseline : baselines) {
+				baseline.toggleWeaknessMode();
+			}
 		}
 
 		if (omTrigger.process(getParam(OM_PARAM).getValue())) {
 			operatingRange = static_cast<VoltageRange>((operatingRange + 1) % RANGES_LEN);
 		}
 
-		const float recoverySpeed = getAttenuverted(RISE_PARAM, RISE_INPUT, RISE_CV_PARAM, RISE_PARAM_MIN, RISE_PARAM_MAX);
-		baseline.setRecoverySpeed(recoverySpeed);
-
-		if (invertTrigger.process(getInput(INVERT_INPUT).getVoltage())) {
-			baseline.invert();
+		PhoenixBusMessage bus;
+		if (isFollowing()) {
+			PhoenixBusMessage* message = static_cast<PhoenixBusMessage*>(getLeftExpander().consumerMessage);
+			bus = *message;
+
+			// Consume the events so they aren't replayed if the leader stops flipping, e.g. when bypassed.
+			message->hitMask = 0;
+			message->invertMask = 0;
+			message->sidechain = false;
+		} else {
+			bus.channels = std::max(getInput(HIT_INPUT).getChannels(), getInput(INVERT_INPUT).getChannels());
+			bus.sidechain = sidechain;
+
+			const bool sidechainBlock = sidechain && sidechainDivider.process();
+			float attackCoef = 0.f;
+			float releaseCoef = 0.f;
+			int windowBlocks = 0;
+			float windowCoef = 0.f;
+			float threshold = 0.f;
+			float scRange = 1.f;
+			if (sidechainBlock) {
+				const float attack = getParam(SC_ATTACK_PARAM).getValue();
+				attackCoef = 1.f - std::exp(-EnvelopeFollower::BLOCK_SIZE / (attack * args.sampleRate));
+				const float release = getParam(SC_RELEASE_PARAM).getValue();
+				releaseCoef = 1.f - std::exp(-EnvelopeFollower::BLOCK_SIZE / (release * args.sampleRate));
+				windowBlocks = static_cast<int>(std::ceil(EnvelopeFollower::WINDOW * args.sampleRate / EnvelopeFollower::BLOCK_SIZE));
+				windowCoef = 1.f / windowBlocks;
+				threshold = getParam(SC_THRESHOLD_PARAM).getValue();
+				scRange = getParam(SC_RANGE_PARAM).getValue();
+			}
+
+			for (int c = 0; c < std::max(bus.channels, 1); c++) {
+				if (sidechain) {
+					followers[c].accumulate(getInput(HIT_INPUT).getPolyVoltage(c), followerMode);
+
+					if (sidechainBlock) {
+						// Land exactly on the previous target, then ramp towards the new one over the next block.
+						// A level of threshold + range ducks by the full hit strength.
+						duckAmounts[c] = duckTargets[c];
+
+						const float level = followers[c].processBlock(followerMode, attackCoef, releaseCoef, windowBlocks, windowCoef);
+						duckTargets[c] = clamp((level - threshold) / scRange, 0.f, 1.f);
+						duckSteps[c] = (duckTargets[c] - duckAmounts[c]) / EnvelopeFollower::BLOCK_SIZE;
+					} else {
+						duckAmounts[c] = clamp(duckAmounts[c] + duckSteps[c], 0.f, 1.f);
+					}
+
+					bus.duckAmounts[c] = duckAmounts[c];
+				} else {
+					bus.hitMask |= weakenTriggers[c].process(getInput(HIT_INPUT).getPolyVoltage(c), 0.1f, 2.f) << c;
+				}
+				bus.invertMask |= invertTriggers[c].process(getInput(INVERT_INPUT).getPolyVoltage(c)) << c;
+			}
 		}
 
-		bool hasFallen = false;
-		if (weakenTrigger.process(getInput(HIT_INPUT).getVoltage(), 0.1f, 2.f)) {
-			hasFallen = baseline.weaken(getAttenuverted(FALL_PARAM, FALL_INPUT, FALL_CV_PARAM, FALL_PARAM_MIN, FALL_PARAM_MAX));
+		Module* right = getRightExpander().module;
+		if (right && right->model == modelPhoenix) {
+			*static_cast<PhoenixBusMessage*>(right->getLeftExpander().producerMessage) = bus;
+			right->getLeftExpander().requestMessageFlip();
 		}
 
-		baseline.process(args.sampleTime);
+		const int channels = std::max({1, getInput(MAIN_INPUT).getChannels(), bus.channels});
+		for (int c = channels; c < lastChannels; c++) {
+			resetVoice(c);
+		}
+		lastChannels = channels;
 
 		Range range = getOperatingRange();
 
-		// TODO: Polyphony.
-		const float signal = clamp(getInput(MAIN_INPUT).getVoltage(), range.min, range.max);
-
-		float out = 0.f;
-		switch (attenuationMode) {
-			case ATTENUATION:
-				out = clamp(signal * baseline.getCurrent(), range.min, range.max);
-				break;
-			case NUDGE:
-				const float new_max = rescale(baseline.getCurrent(), 0.f, 1.f, range.min, range.max);
-				out = rescale(signal, range.min, range.max, range.min, new_max);
-				break;
+		int fallenMask = 0;
+		int duckFallenMask = 0;
+		float states[16] = {};
+		for (int c = 0; c < channels; c++) {
+			BaselineTracker& baseline = baselines[c];
+			baseline.setLinExpRatio(linExpRatio);
+
+			const float recoverySpeed = getAttenuverted(RISE_PARAM, RISE_INPUT, RISE_CV_PARAM, RISE_PARAM_MIN, RISE_PARAM_MAX, c);
+			baseline.setRecoverySpeed(recoverySpeed);
+
+			// A mono hit bus drives every voice.
+			const int lane = bus.channels > 1 ? c : 0;
+
+			if (bus.invertMask & (1 << lane)) {
+				baseline.invert();
+			}
+
+			if (bus.hitMask & (1 << lane)) {
+				const bool hasFallen = baseline.weaken(getAttenuverted(FALL_PARAM, FALL_INPUT, FALL_CV_PARAM, FALL_PARAM_MIN, FALL_PARAM_MAX, c));
+				fallenMask |= hasFallen << c;
+			}
+
+			if (bus.sidechain) {
+				const float strength = getAttenuverted(FALL_PARAM, FALL_INPUT, FALL_CV_PARAM, FALL_PARAM_MIN, FALL_PARAM_MAX, c);
+				baseline.duck(clamp(bus.duckAmounts[lane] * strength, 0.f, 1.f));
+				duckFallenMask |= baseline.isFallen() << c;
+			}
+
+			baseline.process();
+			states[c] = baseline.getState();
+
+			const float signal = clamp(getInput(MAIN_INPUT).getPolyVoltage(c), range.min, range.max);
+
+			float out = 0.f;
+			switch (attenuationMode) {
+				case ATTENUATION:
+					out = clamp(signal * baseline.getCurrent(), range.min, range.max);
+					break;
+				case NUDGE:
+					const float new_max = rescale(baseline.getCurrent(), 0.f, 1.f, range.min, range.max);
+					out = rescale(signal, range.min, range.max, range.min, new_max);
+					break;
+			}
+
+			getOutput(MAIN_OUTPUT).setVoltage(out, c);
+			getOutput(AUX_OUTPUT).setVoltage(rescale(baseline.getCurrent(), 0.f, 1.f, -5.f, 5.f), c);
 		}
 
-		if (baseline.getState() == BaselineTracker::RECOVERED) {
-			risen.trigger();
+		// Lanes past `channels` are zeroed and never compare equal to RECOVERED.
+		int mask = 0;
+		for (int c = 0; c < channels; c += 4) {
+			const simd::float_4 laneStates = simd::float_4::load(&states[c]);
+			mask |= simd::movemask(laneStates == simd::float_4(BaselineTracker::RECOVERED)) << c;
 		}
-		getOutput(RISEN_OUTPUT).setVoltage(risen.process(args.sampleTime) ? 10.f : 0.f);
-
-		if (hasFallen) {
-			fallen.trigger();
+		const int risenMask = mask & ~recoveredMask;
+		recoveredMask = mask;
+
+		fallenMask |= duckFallenMask & ~duckedMask;
+		duckedMask = (duckedMask | duckFallenMask) & ~mask;
+
+		for (int c = 0; c < channels; c++) {
+			if (risenMask & (1 << c)) {
+				risen[c].trigger();
+			}
+			if (fallenMask & (1 << c)) {
+				fallen[c].trigger();
+			}
+
+			getOutput(RISEN_OUTPUT).setVoltage(risen[c].process() ? 10.f : 0.f, c);
+			getOutput(FALLEN_OUTPUT).setVoltage(fallen[c].process() ? 10.f : 0.f, c);
 		}
-		getOutput(FALLEN_OUTPUT).setVoltage(fallen.process(args.sampleTime) ? 10.f : 0.f);
 
-		const float aux = rescale(baseline.getCurrent(), 0.f, 1.f, -5.f, 5.f);
-		getOutput(AUX_OUTPUT).setVoltage(aux);
-		getOutput(MAIN_OUTPUT).setVoltage(out);
+		getOutput(MAIN_OUTPUT).setChannels(channels);
+		getOutput(AUX_OUTPUT).setChannels(channels);
+		getOutput(RISEN_OUTPUT).setChannels(channels);
+		getOutput(FALLEN_OUTPUT).setChannels(channels);
 
 		setLight(AM_LIGHT, 1.f, attenuationMode == ATTENUATION ? GREEN : BLUE, args.sampleTime);
-		setLight(WM_LIGHT, 1.f, baseline.getWeaknessMode() == BaselineTracker::ALWAYS ? CYAN : ORANGE, args.sampleTime);
+		setLight(WM_LIGHT, 1.f, baselines[0].getWeaknessMode() == BaselineTracker::ALWAYS ? CYAN : ORANGE, args.sampleTime);
 
 		Color omColor;
 		switch (operatingRange) {
@@ -259,6 +555,55 @@ struct Phoenix final : Module {
 		setLight(OM_LIGHT, 1.f, omColor, args.sampleTime);
 	}
 
+	void resetVoice(const int c) {
+		baselines[c].reset();
+		risen[c].reset();
+		fallen[c].reset();
+		followers[c].reset();
+		duckAmounts[c] = 0.f;
+		duckTargets[c] = 0.f;
+		duckSteps[c] = 0.f;
+		duckedMask &= ~(1 << c);
+	}
+
+	bool isFollowing() {
+		const Module* left = getLeftExpander().module;
+		return linked && left && left->model == modelPhoenix;
+	}
+
+	json_t* dataToJson() override {
+		json_t* rootJ = json_object();
+		json_object_set_new(rootJ, "linked", json_boolean(linked));
+		json_object_set_new(rootJ, "sidechain", json_boolean(sidechain));
+		json_object_set_new(rootJ, "followerMode", json_integer(followerMode));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t* rootJ) override {
+		json_t* linkedJ = json_object_get(rootJ, "linked");
+		if (linkedJ) {
+			linked = json_boolean_value(linkedJ);
+		}
+
+		json_t* sidechainJ = json_object_get(rootJ, "sidechain");
+		if (sidechainJ) {
+			sidechain = json_boolean_value(sidechainJ);
+		}
+
+		json_t* followerModeJ = json_object_get(rootJ, "followerMode");
+		if (followerModeJ) {
+			followerMode = static_cast<EnvelopeFollower::Mode>(json_integer_value(followerModeJ));
+		}
+	}
+
+	void onSampleRateChange(const SampleRateChangeEvent& e) override {
+		for (int c = 0; c < 16; c++) {
+			baselines[c].setSampleRate(e.sampleRate);
+			risen[c].setSampleRate(e.sampleRate);
+			fallen[c].setSampleRate(e.sampleRate);
+		}
+	}
+
 	enum Color { GREEN, BLUE, ORANGE, CYAN };
 
 	void setLight(const LightId lightId, const float brightness, const Color color, float delta) {
@@ -292,14 +637,14 @@ struct Phoenix final : Module {
 		getLight(lightId + 2).setBrightnessSmooth(b, delta);
 	}
 
-	float getAttenuverted(const ParamId paramId, const InputId inputId, const ParamId attParamId, const float paramMin, const float paramMax) {
+	float getAttenuverted(const ParamId paramId, const InputId inputId, const ParamId attParamId, const float paramMin, const float paramMax, const int channel) {
 		const float param = getParam(paramId).getValue();
 		if (!getInput(inputId).isConnected()) {
 			return param;
 		}
 
 		const float att = getParam(attParamId).getValue();
-		float in = getInput(inputId).getVoltage();
+		float in = getInput(inputId).getPolyVoltage(channel);
 		in = rescale(in, -5.f, 5.f, paramMin, paramMax);
 
 		return clamp(param + in * att, paramMin, paramMax);
@@ -327,6 +672,15 @@ struct Phoenix final : Module {
 };
 
 
+// The panel has no room left, so the sidechain controls live in the context menu.
+struct ParamSlider final : ui::Slider {
+	explicit ParamSlider(ParamQuantity* paramQuantity) {
+		quantity = paramQuantity;
+		box.size.x = 200.f;
+	}
+};
+
+
 struct PhoenixWidget final : ModuleWidget {
 	explicit PhoenixWidget(Phoenix* module) {
 		setModule(module);
@@ -352,6 +706,33 @@ struct PhoenixWidget final : ModuleWidget {
 		addOutput(createOutputCentered<DarkPJ301MPort>(mm2px(Vec(8.25, 113.75)), module, Phoenix::AUX_OUTPUT));
 		addOutput(createOutputCentered<DarkPJ301MPort>(mm2px(Vec(22.25, 113.75)), module, Phoenix::MAIN_OUTPUT));
 	}
+
+	void appendContextMenu(Menu* menu) override {
+		Phoenix* module = getModule<Phoenix>();
+
+		menu->addChild(new MenuSeparator);
+		menu->addChild(createBoolPtrMenuItem("Follow hits from Phoenix on the left", "", &module->linked));
+
+		menu->addChild(new MenuSeparator);
+		MenuItem* sidechainItem = createBoolPtrMenuItem("Sidechain mode (HIT as audio)", "", &module->sidechain);
+		sidechainItem->disabled = module->isFollowing();
+		menu->addChild(sidechainItem);
+
+		// Followers only use the leader's detector, so its settings are shown on the leader alone.
+		if (module->isFollowing()) {
+			menu->addChild(createMenuLabel("Linked: ducking follows the leader's sidechain"));
+			return;
+		}
+		if (!module->sidechain) {
+			return;
+		}
+
+		menu->addChild(createIndexPtrSubmenuItem("Sidechain detector", {"Peak", "RMS"}, &module->followerMode));
+		menu->addChild(new ParamSlider(module->paramQuantities[Phoenix::SC_ATTACK_PARAM]));
+		menu->addChild(new ParamSlider(module->paramQuantities[Phoenix::SC_RELEASE_PARAM]));
+		menu->addChild(new ParamSlider(module->paramQuantities[Phoenix::SC_THRESHOLD_PARAM]));
+		menu->addChild(new ParamSlider(module->paramQuantities[Phoenix::SC_RANGE_PARAM]));
+	}
 };
 
 